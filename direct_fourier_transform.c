@@ -58,6 +58,27 @@ void init_config(Config *config)
 	// note: data can be either single or double precision
 	config->vis_file    = "../example_visibilities.txt";
 
+	// Compute visibility uvw coordinates on the fly from an antenna
+	// layout and observation time grid, rather than storing them
+	// per visibility (overrides synthetic/file visibilities).
+	config->layout_visibilities = false;
+
+	// Cache File for Antennas (used when layout_visibilities is set)
+	// File format : first row = number of antennas in file
+	// subsequent rows = each unique antenna in the form:
+	// x, y, z (meters, equatorial frame)
+	config->antenna_file = "../example_antennas.txt";
+
+	// Number of time steps in the observation (layout visibilities)
+	config->num_timesteps = 100;
+
+	// Hour angle of the first time step, and between time steps (hours)
+	config->hour_angle_start = -3.0;
+	config->hour_angle_step  = 0.06;
+
+	// Declination of the phase centre (degrees)
+	config->declination = -30.0;
+
 	// Dimension of Fourier domain grid
 	config->grid_size = 1024;
 
@@ -179,7 +200,7 @@ void load_visibilities(Config *config, Visibility **visibilities)
 		double gaussian_w = 1.0;
 
 		//try randomize visibilities in the center of the grid
-		for(int vis_indx = 0; vis_indx < config->num_visibilities; ++vis_indx)
+		for(size_t vis_indx = 0; vis_indx < config->num_visibilities; ++vis_indx)
 		{	
 			// Using gaussian distribution
             if(config->gaussian_distribution_sources)
@@ -212,7 +233,7 @@ void load_visibilities(Config *config, Visibility **visibilities)
     	}
 
         // Reading in the counter for number of visibilities
-		fscanf(file, "%d\n", &(config->num_visibilities));
+		fscanf(file, "%zu\n", &(config->num_visibilities));
 		*visibilities = calloc(config->num_visibilities, sizeof(Visibility));
 
 		// File found, but was memory allocated?
@@ -234,7 +255,7 @@ void load_visibilities(Config *config, Visibility **visibilities)
 		double wavelength_to_meters = config->frequency_hz / C;
 
 		// Read in n number of visibilities
-		for(int vis_indx = 0; vis_indx < config->num_visibilities; ++vis_indx)
+		for(size_t vis_indx = 0; vis_indx < config->num_visibilities; ++vis_indx)
 		{
 			// Read in provided visibility attributes
 			// u, v, w, brightness (real), brightness (imag), intensity
@@ -252,15 +273,15 @@ void load_visibilities(Config *config, Visibility **visibilities)
 
 		// Clean up
 		fclose(file);
-		printf(">>> UPDATE: Successfully loaded %d visibilities from file..\n\n",config->num_visibilities);
+		printf(">>> UPDATE: Successfully loaded %zu visibilities from file..\n\n",config->num_visibilities);
 	}
 }
 
 // Performs the inverse direct fourier transformation to obtain the complex brightness
 // of each visibility from each identified source. This is the meat of the algorithm.
-void extract_visibilities(Config *config, Source *sources, Visibility *visibilities, int num_visibilities)
+void extract_visibilities(Config *config, Source *sources, Visibility *visibilities, size_t num_visibilities)
 {
-	for(int vis_indx = 0; vis_indx < num_visibilities; ++vis_indx)
+	for(size_t vis_indx = 0; vis_indx < num_visibilities; ++vis_indx)
 	{
 		Visibility *vis = &visibilities[vis_indx];
 		Complex source_sum = (Complex) {.real = 0.0, .imaginary = 0.0};
@@ -307,14 +328,14 @@ void save_visibilities(Config *config, Visibility *visibilities)
 	printf(">>> UPDATE: Writing visibilities to file...\n\n");
 
 	// Record number of visibilities
-	fprintf(file, "%d\n", config->num_visibilities);
+	fprintf(file, "%zu\n", config->num_visibilities);
 
 	// Used to scale visibility coordinates from meters to
 	// wavelengths (useful for gridding, inverse DFT etc.)
 	double meters_to_wavelengths = config->frequency_hz / C;
 
 	// Record individual visibilities
-	for(int vis_indx = 0; vis_indx < config->num_visibilities; ++vis_indx)
+	for(size_t vis_indx = 0; vis_indx < config->num_visibilities; ++vis_indx)
 	{
 		// u, v, w, real, imag, intensity
 		fprintf(file, "%lf %lf %lf %lf %lf %lf\n",
@@ -331,6 +352,180 @@ void save_visibilities(Config *config, Visibility *visibilities)
 	printf(">>> UPDATE: Completed writing of visibilities to file...\n\n");
 }
 
+// Loads antenna positions into memory from some antenna file, and
+// derives the number of baselines and visibilities in the observation.
+void load_antennas(Config *config, Antenna **antennas)
+{
+	*antennas = NULL;
+
+	if(config->num_timesteps <= 0)
+	{
+		printf(">>> ERROR: Observation must have at least one time step...\n\n");
+		return;
+	}
+
+	printf(">>> UPDATE: Using Antennas from file...\n\n");
+	FILE *file = fopen(config->antenna_file, "r");
+	if(file == NULL)
+	{
+		printf(">>> ERROR: Unable to locate antennas file...\n\n");
+		return;
+	}
+
+	// Reading in the counter for number of antennas
+	fscanf(file, "%d\n", &(config->num_antennas));
+
+	// At least one baseline is needed to form any visibilities
+	if(config->num_antennas < 2)
+	{
+		printf(">>> ERROR: Antenna layout must have at least two antennas...\n\n");
+		fclose(file);
+		return;
+	}
+
+	*antennas = calloc(config->num_antennas, sizeof(Antenna));
+
+	if(*antennas == NULL)
+	{
+		printf(">>> ERROR: Unable to allocate memory for antennas...\n\n");
+		if(file) fclose(file);
+		return;
+	}
+
+	double x = 0.0;
+	double y = 0.0;
+	double z = 0.0;
+
+	// Read in n number of antennas
+	for(int ant_indx = 0; ant_indx < config->num_antennas; ++ant_indx)
+	{
+		// Read in provided antenna position
+		fscanf(file, "%lf %lf %lf\n", &x, &y, &z);
+
+		(*antennas)[ant_indx] = (Antenna) {.x = x, .y = y, .z = z};
+	}
+
+	// Every unique pair of antennas forms one baseline per time step
+	config->num_baselines    = (size_t) config->num_antennas * (config->num_antennas - 1) / 2;
+	config->num_visibilities = config->num_baselines * (size_t) config->num_timesteps;
+
+	// Clean up
+	fclose(file);
+	printf(">>> UPDATE: Successfully loaded %d antennas (%zu visibilities) from file..\n\n",
+		config->num_antennas, config->num_visibilities);
+}
+
+// Rotates each antenna position into uvw (wavelengths) for the hour angle of the
+// given time step. Baseline uvw is the difference of two antenna uvw terms, so this
+// is done once per antenna rather than once per baseline.
+void compute_antenna_uvw(Config *config, Antenna *antennas, int timestep, AntennaUVW *antenna_uvw)
+{
+	double hour_angle  = (config->hour_angle_start + timestep * config->hour_angle_step) * M_PI / 12.0;
+	double declination = config->declination * M_PI / 180.0;
+	double sin_ha      = sin(hour_angle);
+	double cos_ha      = cos(hour_angle);
+	double sin_dec     = sin(declination);
+	double cos_dec     = cos(declination);
+	double meters_to_wavelengths = config->frequency_hz / C;
+
+	for(int ant_indx = 0; ant_indx < config->num_antennas; ++ant_indx)
+	{
+		Antenna *ant = &antennas[ant_indx];
+
+		antenna_uvw[ant_indx] = (AntennaUVW) {
+			.u = (sin_ha * ant->x + cos_ha * ant->y) * meters_to_wavelengths,
+			.v = (-sin_dec * cos_ha * ant->x + sin_dec * sin_ha * ant->y
+				+ cos_dec * ant->z) * meters_to_wavelengths,
+			.w = (cos_dec * cos_ha * ant->x - cos_dec * sin_ha * ant->y
+				+ sin_dec * ant->z) * meters_to_wavelengths};
+	}
+}
+
+// Performs the direct fourier transformation for an observation described by an
+// antenna layout and time grid. Baseline uvw is generated per time step into a
+// reusable buffer, so only the complex brightness of each visibility is stored.
+// note: antenna_uvw holds num_antennas terms and baselines holds num_baselines
+// visibilities; both are scratch space owned by the caller.
+// note: visibilities are ordered by time step, then by antenna pair (p < q)
+void extract_layout_visibilities(Config *config, Source *sources, Antenna *antennas, AntennaUVW *antenna_uvw,
+	Visibility *baselines, Complex *brightness)
+{
+	for(int time_indx = 0; time_indx < config->num_timesteps; ++time_indx)
+	{
+		compute_antenna_uvw(config, antennas, time_indx, antenna_uvw);
+
+		size_t bl_indx = 0;
+		for(int p = 0; p < config->num_antennas - 1; ++p)
+		{
+			for(int q = p + 1; q < config->num_antennas; ++q)
+			{
+				baselines[bl_indx++] = (Visibility) {
+					.u = antenna_uvw[q].u - antenna_uvw[p].u,
+					.v = antenna_uvw[q].v - antenna_uvw[p].v,
+					.w = (config->forceZeroWTerm) ? 0.0 : antenna_uvw[q].w - antenna_uvw[p].w};
+			}
+		}
+
+		extract_visibilities(config, sources, baselines, config->num_baselines);
+
+		Complex *time_brightness = &brightness[(size_t) time_indx * config->num_baselines];
+		for(bl_indx = 0; bl_indx < config->num_baselines; ++bl_indx)
+			time_brightness[bl_indx] = baselines[bl_indx].brightness;
+	}
+}
+
+// Saves the extracted layout visibility data to file, regenerating the uvw
+// coordinates of each visibility (antenna_uvw is caller owned scratch space).
+// Uses the same format as save_visibilities.
+void save_layout_visibilities(Config *config, Antenna *antennas, AntennaUVW *antenna_uvw, Complex *brightness)
+{
+	// Save visibilities to file
+	FILE *file = fopen(config->vis_file, "w");
+
+	// Unable to open file
+	if(file == NULL)
+	{
+		printf(">>> ERROR: Unable to save visibilities to file...\n\n");
+		return;
+	}
+
+	printf(">>> UPDATE: Writing visibilities to file...\n\n");
+
+	// Record number of visibilities
+	fprintf(file, "%zu\n", config->num_visibilities);
+
+	// Used to scale visibility coordinates from wavelengths
+	// back to meters, as per save_visibilities
+	double meters_to_wavelengths = config->frequency_hz / C;
+
+	size_t vis_indx = 0;
+	for(int time_indx = 0; time_indx < config->num_timesteps; ++time_indx)
+	{
+		compute_antenna_uvw(config, antennas, time_indx, antenna_uvw);
+
+		for(int p = 0; p < config->num_antennas - 1; ++p)
+		{
+			for(int q = p + 1; q < config->num_antennas; ++q, ++vis_indx)
+			{
+				double w = (config->forceZeroWTerm) ? 0.0 : antenna_uvw[q].w - antenna_uvw[p].w;
+
+				// u, v, w, real, imag, intensity
+				fprintf(file, "%lf %lf %lf %lf %lf %lf\n",
+					(antenna_uvw[q].u - antenna_uvw[p].u) / meters_to_wavelengths,
+					(antenna_uvw[q].v - antenna_uvw[p].v) / meters_to_wavelengths,
+					w / meters_to_wavelengths,
+					brightness[vis_indx].real,
+					brightness[vis_indx].imaginary,
+					1.0); // static intensity (for now)
+			}
+		}
+	}
+
+	// Clean up
+	fclose(file);
+	printf(">>> UPDATE: Completed writing of visibilities to file...\n\n");
+}
+
 // Generate a random double in range [min, max)
 double random_in_range(double min, double max)
 {
@@ -376,6 +571,12 @@ void unit_test_init_config(Config *config)
 	config->min_w = config->min_v;
 	config->max_w = config->max_v;
 	config->num_visibilities = 1;
+	config->layout_visibilities = false;
+	config->antenna_file = "../unit_test_antennas.txt";
+	config->num_timesteps = 10;
+	config->hour_angle_start = -3.0;
+	config->hour_angle_step  = 0.6;
+	config->declination = -30.0;
 }
 
 double unit_test_generate_approximate_visibilities(void)
@@ -400,7 +601,7 @@ double unit_test_generate_approximate_visibilities(void)
 		return error;
 	}
 
-	fscanf(file, "%d\n", &(config.num_visibilities));
+	fscanf(file, "%zu\n", &(config.num_visibilities));
 
     double u = 0.0;
     double v = 0.0;
@@ -412,7 +613,7 @@ double unit_test_generate_approximate_visibilities(void)
 	Visibility test_visibility;
 	Visibility approx_visibility[1]; // testing one at a time
 
-	for(int vis_indx = 0; vis_indx < config.num_visibilities; ++vis_indx)
+	for(size_t vis_indx = 0; vis_indx < config.num_visibilities; ++vis_indx)
 	{
 		fscanf(file, "%lf %lf %lf %lf %lf %lf\n", &u, &v, &w, &(brightness.real),
         	&(brightness.imaginary), &intensity);
@@ -452,4 +653,134 @@ double unit_test_generate_approximate_visibilities(void)
 	printf(">>> INFO: Measured difference in visibilities is %f\n", difference);
 
 	return difference;
-}
\ No newline at end of file
+}
+
+double unit_test_layout_visibilities_difference(void)
+{
+	// used to invalidate the unit test
+	double error = DBL_MAX;
+
+	Config config;
+	unit_test_init_config(&config);
+
+	Source *sources = NULL;
+	load_sources(&config, &sources);
+	if(sources == NULL)
+		return error;
+
+	Antenna *antennas = NULL;
+	load_antennas(&config, &antennas);
+	if(antennas == NULL)
+	{
+		free(sources);
+		return error;
+	}
+
+	Complex *brightness     = calloc(config.num_visibilities, sizeof(Complex));
+	AntennaUVW *antenna_uvw = calloc(config.num_antennas, sizeof(AntennaUVW));
+	Visibility *baselines   = calloc(config.num_baselines, sizeof(Visibility));
+	if(brightness == NULL || antenna_uvw == NULL || baselines == NULL)
+	{
+		if(baselines)   free(baselines);
+		if(antenna_uvw) free(antenna_uvw);
+		if(brightness)  free(brightness);
+		free(antennas);
+		free(sources);
+		return error;
+	}
+
+	extract_layout_visibilities(&config, sources, antennas, antenna_uvw, baselines, brightness);
+
+	// Rotate each baseline vector directly (no per-antenna reuse) and
+	// measure one visibility at a time with explicit uvw coordinates
+	double declination = config.declination * M_PI / 180.0;
+	double meters_to_wavelengths = config.frequency_hz / C;
+	double difference = 0.0;
+	Visibility explicit_visibility[1];
+	size_t vis_indx = 0;
+
+	for(int time_indx = 0; time_indx < config.num_timesteps; ++time_indx)
+	{
+		double hour_angle = (config.hour_angle_start + time_indx * config.hour_angle_step) * M_PI / 12.0;
+
+		for(int p = 0; p < config.num_antennas - 1; ++p)
+		{
+			for(int q = p + 1; q < config.num_antennas; ++q, ++vis_indx)
+			{
+				double x = antennas[q].x - antennas[p].x;
+				double y = antennas[q].y - antennas[p].y;
+				double z = antennas[q].z - antennas[p].z;
+
+				explicit_visibility[0] = (Visibility) {
+					.u = (sin(hour_angle) * x + cos(hour_angle) * y) * meters_to_wavelengths,
+					.v = (-sin(declination) * cos(hour_angle) * x + sin(declination) * sin(hour_angle) * y
+						+ cos(declination) * z) * meters_to_wavelengths,
+					.w = (cos(declination) * cos(hour_angle) * x - cos(declination) * sin(hour_angle) * y
+						+ sin(declination) * z) * meters_to_wavelengths};
+
+				extract_visibilities(&config, sources, explicit_visibility, 1);
+
+				double current_difference = sqrt(pow(explicit_visibility[0].brightness.real
+											- brightness[vis_indx].real, 2.0)
+											+ pow(explicit_visibility[0].brightness.imaginary
+											- brightness[vis_indx].imaginary, 2.0));
+
+				if(current_difference > difference)
+					difference = current_difference;
+			}
+		}
+	}
+
+	// Clean up
+	free(baselines);
+	free(antenna_uvw);
+	free(brightness);
+	free(antennas);
+	free(sources);
+
+	printf(">>> INFO: Measured difference in layout visibilities is %f\n", difference);
+
+	return difference;
+}
+
+double unit_test_antenna_uvw_difference(void)
+{
+	Config config;
+	unit_test_init_config(&config);
+	config.num_antennas = 1;
+
+	double meters_to_wavelengths = config.frequency_hz / C;
+	Antenna antenna[1] = {(Antenna) {.x = 1000.0, .y = -2000.0, .z = 300.0}};
+	AntennaUVW antenna_uvw[1];
+	double difference = 0.0;
+
+	// Hand derived uvw (meters) for known hour angle (hours) and declination (degrees):
+	// HA = 0, dec = 90 gives u = y, v = -x, w = z
+	// HA = 6, dec = 0  gives u = x, v = z,  w = -y
+	// HA = 0, dec = 0  gives u = y, v = z,  w = x
+	double hour_angles[3]  = {0.0, 6.0, 0.0};
+	double declinations[3] = {90.0, 0.0, 0.0};
+	AntennaUVW expected[3] = {
+		{.u = antenna[0].y,  .v = -antenna[0].x, .w = antenna[0].z},
+		{.u = antenna[0].x,  .v = antenna[0].z,  .w = -antenna[0].y},
+		{.u = antenna[0].y,  .v = antenna[0].z,  .w = antenna[0].x}
+	};
+
+	for(int test_indx = 0; test_indx < 3; ++test_indx)
+	{
+		config.hour_angle_start = hour_angles[test_indx];
+		config.declination      = declinations[test_indx];
+		compute_antenna_uvw(&config, antenna, 0, antenna_uvw);
+
+		double current_difference = fabs(antenna_uvw[0].u - expected[test_indx].u * meters_to_wavelengths)
+								  + fabs(antenna_uvw[0].v - expected[test_indx].v * meters_to_wavelengths)
+								  + fabs(antenna_uvw[0].w - expected[test_indx].w * meters_to_wavelengths);
+
+		if(current_difference > difference)
+			difference = current_difference;
+	}
+
+	printf(">>> INFO: Measured difference in antenna uvw is %f\n", difference);
+
+	return difference;
+}
@@ -59,13 +59,27 @@ typedef struct Visibility {
 	double intensity;
 } Visibility;
 
+typedef struct Antenna {
+	double x;
+	double y;
+	double z;
+} Antenna;
+
+typedef struct AntennaUVW {
+	double u;
+	double v;
+	double w;
+} AntennaUVW;
+
 typedef struct Config {
-	int num_visibilities;
+	size_t num_visibilities;
 	int num_sources;
 	char *source_file;
 	char *vis_file;
+	char *antenna_file;
 	bool synthetic_sources;
 	bool synthetic_visibilities;
+	bool layout_visibilities;
 	bool gaussian_distribution_sources;
 	bool forceZeroWTerm;
 	double min_u;
@@ -78,6 +92,12 @@ typedef struct Config {
 	double cell_size;
 	double uv_scale;
 	double frequency_hz;
+	int num_antennas;
+	size_t num_baselines;
+	int num_timesteps;
+	double hour_angle_start;
+	double hour_angle_step;
+	double declination;
 } Config;
 
 
@@ -90,10 +110,19 @@ void load_sources(Config *config, Source **sources);
 
 void load_visibilities(Config *config, Visibility **visibilities);
 
-void extract_visibilities(Config *config, Source *sources, Visibility *visibilities, int num_visibilities);
+void extract_visibilities(Config *config, Source *sources, Visibility *visibilities, size_t num_visibilities);
 
 void save_visibilities(Config *config, Visibility *visibilities);
 
+void load_antennas(Config *config, Antenna **antennas);
+
+void compute_antenna_uvw(Config *config, Antenna *antennas, int timestep, AntennaUVW *antenna_uvw);
+
+void extract_layout_visibilities(Config *config, Source *sources, Antenna *antennas, AntennaUVW *antenna_uvw,
+	Visibility *baselines, Complex *brightness);
+
+void save_layout_visibilities(Config *config, Antenna *antennas, AntennaUVW *antenna_uvw, Complex *brightness);
+
 double random_in_range(double min, double max);
 
 double generate_sample_normal(void);
@@ -102,6 +131,10 @@ void unit_test_init_config(Config *config);
 
 double unit_test_generate_approximate_visibilities(void);
 
+double unit_test_layout_visibilities_difference(void);
+
+double unit_test_antenna_uvw_difference(void);
+
 #endif /* DIRECT_FOURIER_TRANSFORM_H_ */
 
 #ifdef __cplusplus
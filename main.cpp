@@ -37,6 +37,54 @@ int main(int argc, char **argv)
 	if(sources == NULL)
 		return EXIT_FAILURE;
 
+	// Generate visibility uvw on the fly from an antenna layout
+	if(config.layout_visibilities)
+	{
+		Antenna *antennas = NULL;
+		load_antennas(&config, &antennas);
+
+		// Something went wrong during loading of antennas
+		if(antennas == NULL)
+		{
+			if(sources) free(sources);
+			return EXIT_FAILURE;
+		}
+
+		// Only the brightness of each visibility is stored, uvw is
+		// generated per time step into the antenna and baseline buffers
+		Complex *brightness     = (Complex*) calloc(config.num_visibilities, sizeof(Complex));
+		AntennaUVW *antenna_uvw = (AntennaUVW*) calloc(config.num_antennas, sizeof(AntennaUVW));
+		Visibility *baselines   = (Visibility*) calloc(config.num_baselines, sizeof(Visibility));
+		if(brightness == NULL || antenna_uvw == NULL || baselines == NULL)
+		{
+			printf(">>> ERROR: Unable to allocate memory for visibilities...\n\n");
+			if(baselines)   free(baselines);
+			if(antenna_uvw) free(antenna_uvw);
+			if(brightness)  free(brightness);
+			if(antennas)    free(antennas);
+			if(sources)     free(sources);
+			return EXIT_FAILURE;
+		}
+
+		printf(">>> UPDATE: Performing extraction of visibilities from antenna layout...\n\n");
+		extract_layout_visibilities(&config, sources, antennas, antenna_uvw, baselines, brightness);
+		printf(">>> UPDATE: Visibility extraction complete...\n\n");
+
+		// Save visibilities to file
+		save_layout_visibilities(&config, antennas, antenna_uvw, brightness);
+
+		// Clean up
+		if(baselines)   free(baselines);
+		if(antenna_uvw) free(antenna_uvw);
+		if(brightness)  free(brightness);
+		if(antennas)   free(antennas);
+		if(sources)    free(sources);
+
+		printf(">>> UPDATE: Direct Fourier Transform operations complete, exiting...\n\n");
+
+		return EXIT_SUCCESS;
+	}
+
 	// Obtain Visibilities from file, or synthesize
 	Visibility *visibilities = NULL;
 	load_visibilities(&config, &visibilities);
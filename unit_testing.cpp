@@ -32,6 +32,25 @@ TEST(DFTTest, VisibilitiesApproximatelyEqual)
     ASSERT_LE(difference, threshold); // x <= y
 }
 
+// Test performs DFT on visibilities generated on the fly from an antenna layout and time grid,
+// and compares these against visibilities whose uvw coordinates are computed explicitly
+// per baseline, ensuring the reuse of per-antenna terms does not alter the result.
+TEST(DFTTest, LayoutVisibilitiesApproximatelyEqual)
+{
+	double threshold = 1e-5; // 0.00001
+	double difference = unit_test_layout_visibilities_difference();
+    ASSERT_LE(difference, threshold); // x <= y
+}
+
+// Test compares antenna uvw against hand derived coordinates for known hour angles and
+// declinations, independently validating the rotation and unit conversions.
+TEST(DFTTest, AntennaUVWApproximatelyEqual)
+{
+	double threshold = 1e-5; // 0.00001
+	double difference = unit_test_antenna_uvw_difference();
+    ASSERT_LE(difference, threshold); // x <= y
+}
+
 int main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();